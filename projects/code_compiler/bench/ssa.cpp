@@ -0,0 +1,201 @@
+//	Code Compiler for BlitzLLVM
+//	Copyright(C) 2017 Michael Fabian Dirks
+//
+//	This program is free software : you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.If not, see <https://www.gnu.org/licenses/>.
+
+
+// Compares direct SSA construction against alloca + mem2reg on a large generated Function.
+
+#include "interner.hpp"
+#include "ssabuilder.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <llvm/IR/Dominators.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/Transforms/Utils/PromoteMemToReg.h>
+
+// Reads and writes through SSABuilder.
+struct SSABackend {
+	BlitzLLVM::SSABuilder ssa;
+	std::vector<uint32_t> ids;
+
+	void Declare(llvm::IRBuilder<>& builder, size_t variables) {
+		ssa.Reset();
+		ids.clear();
+		for (size_t idx = 0; idx < variables; idx++) {
+			ids.push_back(BlitzLLVM::Interner::GetGlobal().Intern("v" + std::to_string(idx)));
+			ssa.DeclareVariable(ids.back(), builder.getInt32Ty());
+		}
+	}
+	llvm::Value* Read(llvm::IRBuilder<>& builder, size_t variable) {
+		return ssa.ReadVariable(ids[variable], builder.GetInsertBlock());
+	}
+	void Write(llvm::IRBuilder<>& builder, size_t variable, llvm::Value* value) {
+		ssa.WriteVariable(ids[variable], builder.GetInsertBlock(), value);
+	}
+	void Seal(llvm::BasicBlock* block) {
+		ssa.SealBlock(block);
+	}
+};
+
+// One alloca per variable, loads and stores for every access.
+struct AllocaBackend {
+	std::vector<llvm::AllocaInst*> slots;
+
+	void Declare(llvm::IRBuilder<>& builder, size_t variables) {
+		slots.clear();
+		for (size_t idx = 0; idx < variables; idx++) {
+			slots.push_back(builder.CreateAlloca(builder.getInt32Ty(), nullptr, "v" + std::to_string(idx)));
+			builder.CreateStore(builder.getInt32(0), slots.back());
+		}
+	}
+	llvm::Value* Read(llvm::IRBuilder<>& builder, size_t variable) {
+		return builder.CreateLoad(builder.getInt32Ty(), slots[variable]);
+	}
+	void Write(llvm::IRBuilder<>& builder, size_t variable, llvm::Value* value) {
+		builder.CreateStore(value, slots[variable]);
+	}
+	void Seal(llvm::BasicBlock* block) {}
+};
+
+// While loops with an If in the middle of each body, statements are vA = vB + vC.
+template<typename Backend>
+static llvm::Function* Build(llvm::Module& module, Backend& backend, size_t variables, size_t loops, size_t statements) {
+	llvm::LLVMContext& context = module.getContext();
+	llvm::IRBuilder<> builder(context);
+	llvm::Function* function = llvm::Function::Create(llvm::FunctionType::get(builder.getInt32Ty(), false),
+		llvm::Function::ExternalLinkage, "generated", module);
+	uint32_t seed = 12345;
+	auto next = [&]() { seed = seed * 1664525u + 1013904223u; return (size_t)(seed >> 8) % variables; };
+
+	llvm::BasicBlock* block = llvm::BasicBlock::Create(context, "entry", function);
+	builder.SetInsertPoint(block);
+	backend.Declare(builder, variables);
+	backend.Seal(block);
+
+	for (size_t loop = 0; loop < loops; loop++) {
+		size_t counter = loop % variables;
+		backend.Write(builder, counter, builder.getInt32(10));
+
+		llvm::BasicBlock* header = llvm::BasicBlock::Create(context, "while", function);
+		llvm::BasicBlock* body = llvm::BasicBlock::Create(context, "body", function);
+		llvm::BasicBlock* thenBlock = llvm::BasicBlock::Create(context, "then", function);
+		llvm::BasicBlock* endIf = llvm::BasicBlock::Create(context, "endif", function);
+		llvm::BasicBlock* exit = llvm::BasicBlock::Create(context, "wend", function);
+		builder.CreateBr(header);
+
+		builder.SetInsertPoint(header);
+		builder.CreateCondBr(builder.CreateICmpNE(backend.Read(builder, counter), builder.getInt32(0)), body, exit);
+		backend.Seal(body);
+
+		builder.SetInsertPoint(body);
+		for (size_t stmt = 0; stmt < statements; stmt++) {
+			if (stmt == statements / 2) {
+				builder.CreateCondBr(builder.CreateICmpNE(backend.Read(builder, next()), builder.getInt32(0)), thenBlock, endIf);
+				backend.Seal(thenBlock);
+				builder.SetInsertPoint(thenBlock);
+			}
+			size_t target = next(), left = next(), right = next();
+			backend.Write(builder, target, builder.CreateAdd(backend.Read(builder, left), backend.Read(builder, right)));
+			if (stmt == statements / 2) {
+				builder.CreateBr(endIf);
+				backend.Seal(endIf);
+				builder.SetInsertPoint(endIf);
+			}
+		}
+		backend.Write(builder, counter, builder.CreateSub(backend.Read(builder, counter), builder.getInt32(1)));
+		builder.CreateBr(header);
+		backend.Seal(header);
+		backend.Seal(exit);
+		builder.SetInsertPoint(exit);
+	}
+	builder.CreateRet(backend.Read(builder, 0));
+	return function;
+}
+
+static size_t CountInstructions(llvm::Function* function) {
+	size_t count = 0;
+	for (llvm::BasicBlock& block : *function)
+		count += block.size();
+	return count;
+}
+
+// The entry block has no predecessors, any phi in it means variables were read before it was sealed.
+static bool HasEntryPhis(llvm::Function* function) {
+	llvm::BasicBlock& entry = function->getEntryBlock();
+	return entry.phis().begin() != entry.phis().end();
+}
+
+static double Since(std::chrono::high_resolution_clock::time_point start) {
+	return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+	size_t variables = (argc > 1) ? (size_t)std::atoll(argv[1]) : 256;
+	size_t loops = (argc > 2) ? (size_t)std::atoll(argv[2]) : 500;
+	size_t statements = (argc > 3) ? (size_t)std::atoll(argv[3]) : 64;
+	if (variables == 0)
+		variables = 1;
+
+	std::cout << "SSA construction: " << variables << " variables, " << loops << " loops, " << statements << " statements per loop" << std::endl;
+
+	{
+		llvm::LLVMContext context;
+		llvm::Module module("alloca", context);
+		AllocaBackend backend;
+		auto start = std::chrono::high_resolution_clock::now();
+		llvm::Function* function = Build(module, backend, variables, loops, statements);
+		double build = Since(start);
+		size_t before = CountInstructions(function);
+
+		start = std::chrono::high_resolution_clock::now();
+		llvm::DominatorTree tree(*function);
+		llvm::PromoteMemToReg(backend.slots, tree);
+		double promote = Since(start);
+
+		std::cout << "alloca:     " << build << " ms build, " << before << " instructions" << std::endl;
+		std::cout << "+ mem2reg:  " << promote << " ms, " << (build + promote) << " ms total, " << CountInstructions(function) << " instructions" << std::endl;
+		if (HasEntryPhis(function)) {
+			std::cerr << "mem2reg placed phis in the entry block." << std::endl;
+			return 1;
+		}
+		if (llvm::verifyFunction(*function, &llvm::errs()))
+			return 1;
+	}
+
+	{
+		llvm::LLVMContext context;
+		llvm::Module module("ssa", context);
+		SSABackend backend;
+		auto start = std::chrono::high_resolution_clock::now();
+		llvm::Function* function = Build(module, backend, variables, loops, statements);
+		double build = Since(start);
+
+		std::cout << "SSABuilder: " << build << " ms build, " << CountInstructions(function) << " instructions" << std::endl;
+		if (HasEntryPhis(function)) {
+			std::cerr << "SSABuilder placed phis in the entry block." << std::endl;
+			return 1;
+		}
+		if (llvm::verifyFunction(*function, &llvm::errs()))
+			return 1;
+	}
+	return 0;
+}
\ No newline at end of file
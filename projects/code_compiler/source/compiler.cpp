@@ -19,11 +19,20 @@
 #include "lexer.hpp"
 #include <fstream>
 #include <iostream>
+#include <unordered_map>
 
 BlitzLLVM::Compiler::Compiler() {}
 
 BlitzLLVM::Compiler::~Compiler() {}
 
+void BlitzLLVM::Compiler::SetPipelined(bool pipelined) {
+	m_isPipelined = pipelined;
+}
+
+const BlitzLLVM::SymbolTable& BlitzLLVM::Compiler::GetSymbols() const {
+	return m_symbols;
+}
+
 bool BlitzLLVM::Compiler::Compile(std::string in, std::string out) {
 	std::ifstream infile;
 	infile.open(in);
@@ -32,8 +41,12 @@ bool BlitzLLVM::Compiler::Compile(std::string in, std::string out) {
 		return false;
 	}
 
-	Lexer psr = { infile };
+	// Main program scope, Locals declared outside of a Function live here.
+	m_symbols.EnterScope();
+
+	Parser psr(infile, m_isPipelined);
 	for (auto tkn = psr.GetNextToken(); tkn.first != Lexer::Token::TokenEOF; tkn = psr.GetNextToken()) {
+		TrackSymbols(psr, tkn.first, tkn.second);
 		switch (tkn.first) {
 			case Lexer::Token::TokenEOF:
 				std::cout << "EOF" << std::endl;
@@ -92,7 +105,9 @@ bool BlitzLLVM::Compiler::Compile(std::string in, std::string out) {
 			case Lexer::Token::TokenStop:
 			case Lexer::Token::TokenFor:
 			case Lexer::Token::TokenTo:
+			case Lexer::Token::TokenStep:
 			case Lexer::Token::TokenNext:
+			case Lexer::Token::TokenParallel:
 			case Lexer::Token::TokenWhile:
 			case Lexer::Token::TokenWend:
 			case Lexer::Token::TokenRepeat:
@@ -144,5 +159,211 @@ bool BlitzLLVM::Compiler::Compile(std::string in, std::string out) {
 		}
 	}
 
-	return true;
+	ResolveImplicitLocals();
+	CheckParallelCalls();
+
+	return !m_hasErrors;
 }
+
+
+void BlitzLLVM::Compiler::TrackSymbols(Parser& psr, Lexer::Token tkn, const std::string& text) {
+	bool wasEnd = m_isEnd;
+	bool wasParallel = m_isParallel;
+	bool wasStatementStart = m_isStatementStart;
+	m_isEnd = false;
+	m_isParallel = false;
+	m_isStatementStart = false;
+
+	if (wasParallel && (tkn != Lexer::Token::TokenFor)) {
+		std::cerr << "Expected For after Parallel." << std::endl;
+		m_hasErrors = true;
+	}
+
+	switch (tkn) {
+		case Lexer::Token::TokenThen:
+		case Lexer::Token::TokenElse:
+			m_isStatementStart = true;
+			break;
+		case Lexer::Token::TokenParallel:
+			m_isParallel = true;
+			break;
+		case Lexer::Token::TokenFor:
+			// The loop variable is written by the loop itself.
+			m_forLoops.push_back(wasParallel);
+			if (wasParallel)
+				m_parallelDepth++;
+			m_isParallelHead = wasParallel;
+			m_isStatementStart = true;
+			break;
+		case Lexer::Token::TokenStep:
+			if (m_isParallelHead) {
+				// BlitzParallelFor only counts upward by one.
+				std::cerr << "Step is not supported in Parallel For." << std::endl;
+				m_hasErrors = true;
+			}
+			break;
+		case Lexer::Token::TokenNext:
+			if (!m_forLoops.empty()) {
+				if (m_forLoops.back())
+					m_parallelDepth--;
+				m_forLoops.pop_back();
+			}
+			break;
+		case Lexer::Token::TokenNewLine:
+		case Lexer::Token::TokenColon:
+			m_isStatementStart = true;
+			m_isParallelHead = false;
+			m_isDeclaration = false;
+			m_expectName = false;
+			m_bracketDepth = 0;
+			break;
+		case Lexer::Token::TokenConst:
+		case Lexer::Token::TokenGlobal:
+		case Lexer::Token::TokenLocal:
+			m_isDeclaration = true;
+			m_expectName = true;
+			m_bracketDepth = 0;
+			m_declarationKind = (tkn == Lexer::Token::TokenConst ? SymbolTable::Kind::KindConst
+				: (tkn == Lexer::Token::TokenGlobal ? SymbolTable::Kind::KindGlobal : SymbolTable::Kind::KindLocal));
+			break;
+		case Lexer::Token::TokenEnd:
+			m_isEnd = true;
+			break;
+		case Lexer::Token::TokenFunction:
+			if (wasEnd) {
+				// End Function, back to the main program scope.
+				m_symbols.LeaveScope();
+				m_currentFunction = Interner::InvalidId;
+				m_implicitLocals.clear();
+			} else {
+				m_isFunctionHead = true;
+				m_expectName = true;
+			}
+			break;
+		case Lexer::Token::TokenRoundBracketOpen:
+			m_bracketDepth++;
+			if (m_isFunctionHead) {
+				// Parameters are Locals of the Function.
+				m_isDeclaration = true;
+				m_declarationKind = SymbolTable::Kind::KindLocal;
+				m_expectName = true;
+			}
+			break;
+		case Lexer::Token::TokenRoundBracketClose:
+			if (m_bracketDepth > 0)
+				m_bracketDepth--;
+			if (m_isFunctionHead && (m_bracketDepth == 0)) {
+				m_isFunctionHead = false;
+				m_isDeclaration = false;
+				m_expectName = false;
+			}
+			break;
+		case Lexer::Token::TokenComma:
+			if (m_isDeclaration && (m_bracketDepth == (m_isFunctionHead ? 1u : 0u)))
+				m_expectName = true;
+			break;
+		case Lexer::Token::TokenText:
+		{
+			uint32_t id = Interner::GetGlobal().Intern(text);
+			if (m_expectName) {
+				m_expectName = false;
+				if (m_isFunctionHead && !m_isDeclaration) {
+					if (!m_symbols.Declare(id, SymbolTable::Kind::KindFunction)) {
+						std::cerr << "Duplicate declaration: " << text << std::endl;
+						m_hasErrors = true;
+					}
+					// Enter the scope regardless, so End Function stays balanced.
+					m_symbols.EnterScope();
+					m_currentFunction = id;
+				} else if (!m_symbols.Declare(id, m_declarationKind)) {
+					std::cerr << "Duplicate declaration: " << text << std::endl;
+					m_hasErrors = true;
+				}
+			} else if (wasStatementStart) {
+				if (psr.IsAssignmentAhead()) {
+					TrackAssignment(id);
+				} else {
+					// Not an assignment, so a statement starting with a name is a call.
+					RecordCall(id);
+				}
+			} else if (psr.IsCallAhead() || m_symbols.ResolveFunction(id)) {
+				// Functions live in their own namespace, a variable of the same name does not hide them.
+				RecordCall(id);
+			}
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+void BlitzLLVM::Compiler::TrackAssignment(uint32_t id) {
+	const SymbolTable::Symbol* symbol = m_symbols.Resolve(id);
+	if (!symbol) {
+		// Blitz implicitly declares unknown names as Locals when they are first assigned.
+		m_symbols.Declare(id, SymbolTable::Kind::KindLocal);
+		if (m_currentFunction != Interner::InvalidId) {
+			m_implicitLocals.insert(id);
+			m_implicitAssignments.push_back({ m_currentFunction, id, m_parallelDepth > 0 });
+		}
+	} else if ((symbol->kind == SymbolTable::Kind::KindLocal) && (m_parallelDepth > 0) && m_implicitLocals.count(id)) {
+		m_implicitAssignments.push_back({ m_currentFunction, id, true });
+	} else if (symbol->kind == SymbolTable::Kind::KindGlobal) {
+		if (m_currentFunction != Interner::InvalidId)
+			m_globalWriters.insert(m_currentFunction);
+		if (m_parallelDepth > 0) {
+			std::cerr << "Global may not be written inside Parallel For: " << Interner::GetGlobal().GetName(id) << std::endl;
+			m_hasErrors = true;
+		}
+	}
+}
+
+void BlitzLLVM::Compiler::RecordCall(uint32_t id) {
+	// Builtins end up in here as well, they never write Globals and drop out in CheckParallelCalls.
+	if (m_currentFunction != Interner::InvalidId)
+		m_calls.push_back(std::make_pair(m_currentFunction, id));
+	if (m_parallelDepth > 0)
+		m_parallelCalls.push_back(id);
+}
+
+void BlitzLLVM::Compiler::ResolveImplicitLocals() {
+	// An implicit Local that turned out to name a Global was a write to that Global.
+	for (auto& assignment : m_implicitAssignments) {
+		const SymbolTable::Symbol* symbol = m_symbols.ResolveGlobal(assignment.id);
+		if (!symbol || (symbol->kind != SymbolTable::Kind::KindGlobal))
+			continue;
+		m_globalWriters.insert(assignment.function);
+		if (assignment.isParallel) {
+			std::cerr << "Global may not be written inside Parallel For: " << Interner::GetGlobal().GetName(assignment.id) << std::endl;
+			m_hasErrors = true;
+		}
+	}
+}
+
+void BlitzLLVM::Compiler::CheckParallelCalls() {
+	// A Function writes Globals if it does so itself or calls one that does, walk up from the direct writers.
+	std::unordered_map<uint32_t, std::vector<uint32_t>> callers;
+	for (auto& call : m_calls)
+		callers[call.second].push_back(call.first);
+
+	std::vector<uint32_t> pending(m_globalWriters.begin(), m_globalWriters.end());
+	while (!pending.empty()) {
+		uint32_t callee = pending.back();
+		pending.pop_back();
+
+		auto it = callers.find(callee);
+		if (it == callers.end())
+			continue;
+		for (uint32_t caller : it->second) {
+			if (m_globalWriters.insert(caller).second)
+				pending.push_back(caller);
+		}
+	}
+
+	for (uint32_t id : m_parallelCalls) {
+		if (m_globalWriters.count(id) && m_symbols.ResolveFunction(id)) {
+			std::cerr << "Function writing a Global may not be called inside Parallel For: " << Interner::GetGlobal().GetName(id) << std::endl;
+			m_hasErrors = true;
+		}
+	}
+}
\ No newline at end of file
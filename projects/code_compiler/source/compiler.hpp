@@ -15,7 +15,13 @@
 //	along with this program.If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
+#include "lexer.hpp"
+#include "parser.hpp"
+#include "symboltable.hpp"
 #include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace BlitzLLVM {
 	class Compiler {
@@ -23,8 +29,55 @@ namespace BlitzLLVM {
 		Compiler();
 		~Compiler();
 
+		// Run the Lexer on its own thread, overlapping lexing with the rest of compilation.
+		void SetPipelined(bool pipelined);
+
 		bool Compile(std::string in, std::string out);
 
+		const SymbolTable& GetSymbols() const;
+
 		private:
+		void TrackSymbols(Parser& psr, Lexer::Token tkn, const std::string& text);
+		void TrackAssignment(uint32_t id);
+		void RecordCall(uint32_t id);
+		void ResolveImplicitLocals();
+		void CheckParallelCalls();
+
+		private:
+		bool m_isPipelined = false;
+		SymbolTable m_symbols;
+
+		// Declaration tracking state for TrackSymbols.
+		SymbolTable::Kind m_declarationKind = SymbolTable::Kind::KindLocal;
+		bool m_isDeclaration = false;
+		bool m_expectName = false;
+		bool m_isFunctionHead = false;
+		bool m_isEnd = false;
+		uint32_t m_bracketDepth = 0;
+
+		// Parallel For tracking, bodies must not write to Globals.
+		std::vector<bool> m_forLoops;
+		uint32_t m_parallelDepth = 0;
+		bool m_isParallel = false;
+		bool m_isParallelHead = false;
+		bool m_isStatementStart = true;
+
+		// Functions may be called before they are defined, so calls are checked once everything was seen.
+		uint32_t m_currentFunction = Interner::InvalidId;
+		std::unordered_set<uint32_t> m_globalWriters;
+		std::vector<std::pair<uint32_t, uint32_t>> m_calls; // Caller, callee.
+		std::vector<uint32_t> m_parallelCalls;
+
+		// Globals declared further down are visible inside Functions as well, so implicit Locals
+		// of a Function are only settled once everything was seen.
+		struct ImplicitAssignment {
+			uint32_t function;
+			uint32_t id;
+			bool isParallel;
+		};
+		std::unordered_set<uint32_t> m_implicitLocals;
+		std::vector<ImplicitAssignment> m_implicitAssignments;
+
+		bool m_hasErrors = false;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,105 @@
+//	Code Compiler for BlitzLLVM
+//	Copyright(C) 2017 Michael Fabian Dirks
+//
+//	This program is free software : you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "interner.hpp"
+#include <cctype>
+#include <stdexcept>
+
+const uint32_t BlitzLLVM::Interner::InvalidId;
+
+BlitzLLVM::Interner::Interner() : m_slots(256, InvalidId), m_slotMask(255) {}
+
+BlitzLLVM::Interner::~Interner() {}
+
+BlitzLLVM::Interner& BlitzLLVM::Interner::GetGlobal() {
+	static Interner l_interner;
+	return l_interner;
+}
+
+uint32_t BlitzLLVM::Interner::Intern(const std::string& name) {
+	uint32_t hash = Hash(name);
+	for (uint32_t slot = hash & m_slotMask;; slot = (slot + 1) & m_slotMask) {
+		uint32_t id = m_slots[slot];
+		if (id == InvalidId) {
+			if (m_names.size() >= InvalidId)
+				throw std::overflow_error("Too many unique identifiers.");
+
+			id = (uint32_t)m_names.size();
+			m_names.push_back(name);
+			m_hashes.push_back(hash);
+			m_slots[slot] = id;
+
+			// Keep the load factor at or below 50%.
+			if (m_names.size() * 2 > m_slots.size())
+				Grow();
+			return id;
+		} else if ((m_hashes[id] == hash) && Equals(m_names[id], name)) {
+			return id;
+		}
+	}
+}
+
+uint32_t BlitzLLVM::Interner::Find(const std::string& name) const {
+	uint32_t hash = Hash(name);
+	for (uint32_t slot = hash & m_slotMask;; slot = (slot + 1) & m_slotMask) {
+		uint32_t id = m_slots[slot];
+		if (id == InvalidId) {
+			return InvalidId;
+		} else if ((m_hashes[id] == hash) && Equals(m_names[id], name)) {
+			return id;
+		}
+	}
+}
+
+const std::string& BlitzLLVM::Interner::GetName(uint32_t id) const {
+	return m_names.at(id);
+}
+
+size_t BlitzLLVM::Interner::Size() const {
+	return m_names.size();
+}
+
+uint32_t BlitzLLVM::Interner::Hash(const std::string& name) {
+	// FNV-1a over the lower-cased name.
+	uint32_t hash = 2166136261u;
+	for (char chr : name) {
+		hash ^= (uint8_t)tolower((unsigned char)chr);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+bool BlitzLLVM::Interner::Equals(const std::string& a, const std::string& b) {
+	if (a.size() != b.size())
+		return false;
+	for (size_t idx = 0; idx < a.size(); idx++) {
+		if (tolower((unsigned char)a[idx]) != tolower((unsigned char)b[idx]))
+			return false;
+	}
+	return true;
+}
+
+void BlitzLLVM::Interner::Grow() {
+	m_slots.assign(m_slots.size() * 2, InvalidId);
+	m_slotMask = (uint32_t)m_slots.size() - 1;
+	for (uint32_t id = 0; id < (uint32_t)m_names.size(); id++) {
+		uint32_t slot = m_hashes[id] & m_slotMask;
+		while (m_slots[slot] != InvalidId)
+			slot = (slot + 1) & m_slotMask;
+		m_slots[slot] = id;
+	}
+}
\ No newline at end of file
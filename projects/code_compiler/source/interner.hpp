@@ -0,0 +1,54 @@
+//	Code Compiler for BlitzLLVM
+//	Copyright(C) 2017 Michael Fabian Dirks
+//
+//	This program is free software : you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+#include <string>
+#include <vector>
+#include <inttypes.h>
+
+namespace BlitzLLVM {
+	// Maps identifier names to dense 32-bit IDs. Blitz names are case-insensitive, so
+	// "Variable", "VARIABLE" and "variable" all share one ID; the first spelling seen is kept.
+	class Interner {
+		public:
+		static const uint32_t InvalidId = 0xFFFFFFFFu;
+
+		public:
+		Interner();
+		~Interner();
+
+		static Interner& GetGlobal();
+
+		uint32_t Intern(const std::string& name);
+		uint32_t Find(const std::string& name) const;
+		const std::string& GetName(uint32_t id) const;
+		size_t Size() const;
+
+		private:
+		static uint32_t Hash(const std::string& name);
+		static bool Equals(const std::string& a, const std::string& b);
+		void Grow();
+
+		private:
+		std::vector<std::string> m_names;
+		std::vector<uint32_t> m_hashes;
+
+		// Open addressed, power-of-two sized, holds IDs into m_names.
+		std::vector<uint32_t> m_slots;
+		uint32_t m_slotMask;
+	};
+}
\ No newline at end of file
@@ -223,7 +223,9 @@ BlitzLLVM::Lexer::Token BlitzLLVM::Lexer::ConvertTextToToken(Token in, std::stri
 		// Loop
 		{ "for", Token::TokenFor },
 		{ "to", Token::TokenTo },
+		{ "step", Token::TokenStep },
 		{ "next", Token::TokenNext },
+		{ "parallel", Token::TokenParallel },
 		{ "while", Token::TokenWhile },
 		{ "wend", Token::TokenWend },
 		{ "repeat", Token::TokenRepeat },
@@ -83,7 +83,8 @@ namespace BlitzLLVM {
 			TokenStop /* DEBUGGER! Ignore in Release mode. */,
 
 			// Loop
-			TokenFor, TokenTo, TokenNext,
+			TokenFor, TokenTo, TokenStep, TokenNext,
+			TokenParallel, // Parallel For = TokenParallel, TokenFor.
 			TokenWhile, TokenWend,
 			TokenRepeat, TokenUntil, TokenForever,
 			TokenExit,
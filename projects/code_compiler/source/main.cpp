@@ -31,7 +31,7 @@ PROVE DEFECTIVE, YOU ASSUME THE COST OF ALL NECESSARY SERVICING, REPAIR OR CORRE
 
 int main(int argc, char** argv) {
 	std::string optInput;
-	bool optQuiet, optVerbose;
+	bool optQuiet, optVerbose, optPipelined;
 
 #pragma region Define Program Options
 	boost::program_options::options_description opts_help("Generic");
@@ -45,6 +45,7 @@ int main(int argc, char** argv) {
 	boost::program_options::options_description opts_param("Parameters");
 	opts_param.add_options()
 		("input,i", boost::program_options::value<std::string>(&optInput), "Input .bb file.")
+		("pipelined,p", boost::program_options::value<bool>(&optPipelined)->default_value(false), "Run the lexer on a separate thread.")
 		;
 
 	boost::program_options::options_description opts;
@@ -99,11 +100,12 @@ int main(int argc, char** argv) {
 
 #pragma region Process Input
 	BlitzLLVM::Compiler comp;
-	comp.Compile(optInput, optInput + ".exe");
+	comp.SetPipelined(optPipelined);
+	bool success = comp.Compile(optInput, optInput + ".exe");
 #pragma endregion Process Input
 
 #ifdef _DEBUG
 	std::cin.get();
 #endif
-	return 0;
+	return success ? 0 : 1;
 }
\ No newline at end of file
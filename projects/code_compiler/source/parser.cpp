@@ -16,7 +16,7 @@
 
 #include "parser.hpp"
 
-BlitzLLVM::Parser::Parser(std::istream& in) : m_lexer(in) {
+BlitzLLVM::Parser::Parser(std::istream& in, bool pipelined) : m_tokens(in, pipelined) {
 
 }
 
@@ -24,3 +24,28 @@ BlitzLLVM::Parser::~Parser() {
 
 }
 
+std::pair<BlitzLLVM::Lexer::Token, std::string> BlitzLLVM::Parser::GetNextToken() {
+	return m_tokens.GetNextToken();
+}
+
+const std::pair<BlitzLLVM::Lexer::Token, std::string>& BlitzLLVM::Parser::PeekToken(size_t offset) {
+	return m_tokens.PeekToken(offset);
+}
+
+bool BlitzLLVM::Parser::IsAssignmentAhead() {
+	size_t offset = 0;
+	switch (PeekToken(offset).first) {
+		case Lexer::Token::TokenOctothorp:
+		case Lexer::Token::TokenPercent:
+		case Lexer::Token::TokenDollar:
+			offset++;
+			break;
+		default:
+			break;
+	}
+	return PeekToken(offset).first == Lexer::Token::TokenEqual;
+}
+
+bool BlitzLLVM::Parser::IsCallAhead() {
+	return PeekToken().first == Lexer::Token::TokenRoundBracketOpen;
+}
@@ -16,17 +16,27 @@
 
 #pragma once
 #include "lexer.hpp"
+#include "tokenstream.hpp"
 #include <istream>
+#include <string>
+#include <utility>
 
 namespace BlitzLLVM {
 	class Parser {
 		public:
-		Parser(std::istream& in);
+		Parser(std::istream& in, bool pipelined);
 		~Parser();
 
+		std::pair<Lexer::Token, std::string> GetNextToken();
+		const std::pair<Lexer::Token, std::string>& PeekToken(size_t offset = 0);
 
+		// Whether the name just taken is assigned to, looking past a type suffix.
+		bool IsAssignmentAhead();
+
+		// Whether the name just taken is followed by an argument list.
+		bool IsCallAhead();
 
 		private:
-		Lexer m_lexer;
+		TokenStream m_tokens;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,233 @@
+//	Code Compiler for BlitzLLVM
+//	Copyright(C) 2017 Michael Fabian Dirks
+//
+//	This program is free software : you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "ssabuilder.hpp"
+#include "interner.hpp"
+#include <stdexcept>
+#include <llvm/IR/CFG.h>
+#include <llvm/IR/Constants.h>
+
+// Placed in a definition while the predecessors of its block are visited.
+static llvm::Value* const g_visiting = llvm::DenseMapInfo<llvm::Value*>::getTombstoneKey();
+
+BlitzLLVM::SSABuilder::SSABuilder() {}
+
+BlitzLLVM::SSABuilder::~SSABuilder() {
+	Reset();
+}
+
+void BlitzLLVM::SSABuilder::Reset() {
+	// Removed phis have neither operands nor uses left, so they can go in any order.
+	for (llvm::PHINode* phi : m_removedPhis)
+		phi->deleteValue();
+	m_removedPhis.clear();
+	m_replaced.clear();
+
+	m_slots.clear();
+	m_variables.clear();
+	m_types.clear();
+	m_blockIndices.clear();
+	m_blocks.clear();
+}
+
+void BlitzLLVM::SSABuilder::DeclareVariable(uint32_t variable, llvm::Type* type) {
+	auto it = m_slots.find(variable);
+	if (it != m_slots.end()) {
+		m_types[it->second] = type;
+		return;
+	}
+	m_slots[variable] = (uint32_t)m_variables.size();
+	m_variables.push_back(variable);
+	m_types.push_back(type);
+}
+
+llvm::Type* BlitzLLVM::SSABuilder::GetVariableType(uint32_t variable) const {
+	return m_types[GetSlot(variable)];
+}
+
+void BlitzLLVM::SSABuilder::WriteVariable(uint32_t variable, llvm::BasicBlock* block, llvm::Value* value) {
+	Def(GetSlot(variable), GetBlock(block)) = value;
+}
+
+llvm::Value* BlitzLLVM::SSABuilder::ReadVariable(uint32_t variable, llvm::BasicBlock* block) {
+	return Read(GetSlot(variable), GetBlock(block));
+}
+
+void BlitzLLVM::SSABuilder::SealBlock(llvm::BasicBlock* block) {
+	uint32_t index = GetBlock(block);
+
+	// AddPhiOperands may add blocks and move m_blocks, so take the list out first.
+	auto phis = std::move(m_blocks[index].incompletePhis);
+	m_blocks[index].incompletePhis.clear();
+	for (auto& kv : phis)
+		AddPhiOperands(kv.first, kv.second);
+	m_blocks[index].sealed = true;
+}
+
+bool BlitzLLVM::SSABuilder::IsSealed(llvm::BasicBlock* block) const {
+	auto it = m_blockIndices.find(block);
+	return (it != m_blockIndices.end()) && m_blocks[it->second].sealed;
+}
+
+uint32_t BlitzLLVM::SSABuilder::GetSlot(uint32_t variable) const {
+	auto it = m_slots.find(variable);
+	if (it == m_slots.end())
+		throw std::invalid_argument("Variable was never declared.");
+	return it->second;
+}
+
+uint32_t BlitzLLVM::SSABuilder::GetBlock(llvm::BasicBlock* block) {
+	auto it = m_blockIndices.find(block);
+	if (it != m_blockIndices.end())
+		return it->second;
+
+	uint32_t index = (uint32_t)m_blocks.size();
+	m_blockIndices[block] = index;
+	m_blocks.push_back(BlockInfo{ block, false });
+	return index;
+}
+
+llvm::Value*& BlitzLLVM::SSABuilder::Def(uint32_t slot, uint32_t block) {
+	std::vector<llvm::Value*>& defs = m_blocks[block].defs;
+	if (defs.size() <= slot)
+		defs.resize(m_variables.size(), nullptr);
+	return defs[slot];
+}
+
+llvm::Value* BlitzLLVM::SSABuilder::Read(uint32_t slot, uint32_t block) {
+	llvm::Value*& def = Def(slot, block);
+	if (def == g_visiting) {
+		// Came back to a block whose predecessors are being visited, place its phi to break the cycle.
+		llvm::PHINode* phi = CreatePhi(slot, block);
+		Def(slot, block) = phi;
+		return phi;
+	} else if (def) {
+		def = Forward(def);
+		return def;
+	}
+	return ReadRecursive(slot, block);
+}
+
+llvm::Value* BlitzLLVM::SSABuilder::ReadRecursive(uint32_t slot, uint32_t block) {
+	llvm::BasicBlock* bb = m_blocks[block].block;
+	llvm::Value* value;
+	if (!m_blocks[block].sealed) {
+		// The entry block never gains predecessors, a phi placed there would stay empty.
+		if (bb->isEntryBlock())
+			throw std::logic_error("Entry block must be sealed before variables are read.");
+
+		// Not all predecessors are known yet, fill this in on SealBlock.
+		llvm::PHINode* phi = CreatePhi(slot, block);
+		m_blocks[block].incompletePhis.push_back(std::make_pair(slot, phi));
+		value = phi;
+	} else if (llvm::pred_empty(bb)) {
+		// Blitz variables start out as zero.
+		value = llvm::Constant::getNullValue(m_types[slot]);
+	} else if (llvm::BasicBlock* pred = bb->getUniquePredecessor()) {
+		value = Read(slot, GetBlock(pred));
+	} else {
+		// Visit the predecessors first with a marker in place, and only place a phi if they
+		// disagree or a read looped back to this block. Merges of the same value need none.
+		llvm::SmallVector<llvm::BasicBlock*, 4> preds(llvm::predecessors(bb));
+		llvm::SmallVector<llvm::Value*, 4> values;
+		Def(slot, block) = g_visiting;
+		for (llvm::BasicBlock* pred : preds)
+			values.push_back(Read(slot, GetBlock(pred)));
+
+		llvm::Value* current = Def(slot, block);
+		llvm::PHINode* phi = (current == g_visiting) ? nullptr : llvm::cast<llvm::PHINode>(current);
+		bool isSame = true;
+		for (llvm::Value*& incoming : values) {
+			incoming = Forward(incoming);
+			isSame = isSame && (incoming == values[0]);
+		}
+
+		if (!phi && isSame) {
+			value = values[0];
+		} else {
+			if (!phi)
+				phi = CreatePhi(slot, block);
+			for (size_t idx = 0; idx < preds.size(); idx++)
+				phi->addIncoming(values[idx], preds[idx]);
+			value = TryRemoveTrivialPhi(slot, phi);
+		}
+	}
+	Def(slot, block) = value;
+	return value;
+}
+
+llvm::PHINode* BlitzLLVM::SSABuilder::CreatePhi(uint32_t slot, uint32_t block) {
+	// Named once they turn out to be non-trivial, most phis don't live long enough to need it.
+	llvm::BasicBlock* bb = m_blocks[block].block;
+	if (bb->empty())
+		return llvm::PHINode::Create(m_types[slot], 2, "", bb);
+	return llvm::PHINode::Create(m_types[slot], 2, "", &bb->front());
+}
+
+llvm::Value* BlitzLLVM::SSABuilder::AddPhiOperands(uint32_t slot, llvm::PHINode* phi) {
+	llvm::BasicBlock* block = phi->getParent();
+	for (llvm::BasicBlock* pred : llvm::predecessors(block))
+		phi->addIncoming(Read(slot, GetBlock(pred)), pred);
+	return TryRemoveTrivialPhi(slot, phi);
+}
+
+llvm::Value* BlitzLLVM::SSABuilder::TryRemoveTrivialPhi(uint32_t slot, llvm::PHINode* phi) {
+	llvm::Value* same = nullptr;
+	for (llvm::Value* op : phi->incoming_values()) {
+		if (op == same || op == phi)
+			continue;
+		if (same) {
+			// Merges at least two values, not trivial.
+			if (!phi->hasName())
+				phi->setName(Interner::GetGlobal().GetName(m_variables[slot]));
+			return phi;
+		}
+		same = op;
+	}
+	if (!same) {
+		// Only reachable through itself, the variable was never written.
+		same = llvm::Constant::getNullValue(phi->getType());
+	}
+
+	// Removing this phi may make phis using it trivial as well, those merge the same variable.
+	llvm::SmallVector<llvm::PHINode*, 8> users;
+	for (llvm::User* user : phi->users()) {
+		if (user != phi && llvm::isa<llvm::PHINode>(user))
+			users.push_back(llvm::cast<llvm::PHINode>(user));
+	}
+
+	phi->replaceAllUsesWith(same);
+	phi->dropAllReferences();
+	phi->removeFromParent();
+	m_replaced[phi] = same;
+	m_removedPhis.push_back(phi);
+
+	for (llvm::PHINode* user : users) {
+		if (user->getParent())
+			TryRemoveTrivialPhi(slot, user);
+	}
+
+	// Same may itself have been one of the phis removed above.
+	return Forward(same);
+}
+
+llvm::Value* BlitzLLVM::SSABuilder::Forward(llvm::Value* value) const {
+	// Only phis that were removed have no parent.
+	while (llvm::isa<llvm::PHINode>(value) && !llvm::cast<llvm::PHINode>(value)->getParent())
+		value = m_replaced.lookup(value);
+	return value;
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+//	Code Compiler for BlitzLLVM
+//	Copyright(C) 2017 Michael Fabian Dirks
+//
+//	This program is free software : you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+#include <inttypes.h>
+#include <vector>
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/Instructions.h>
+
+namespace BlitzLLVM {
+	// Builds SSA form for Local variables directly while IR is generated, so no alloca or
+	// mem2reg pass is needed. Follows "Simple and Efficient Construction of SSA Form"
+	// (Braun et al. 2013): reads in unsealed blocks create incomplete phis that are filled
+	// in once all predecessors of the block are known, trivial phis are removed right away.
+	//
+	// A block may be sealed as soon as every branch into it has been emitted:
+	// - Function entry: seal right after creating it and after Reset, before the first read. It has no
+	//   predecessors, reading from it unsealed throws std::logic_error instead of placing an empty phi.
+	// - If/ElseIf/Else: seal each arm after the conditional branch, the merge block after the last arm.
+	// - While/For: seal the body after the header branch, the header after the back edge (Wend/Next).
+	// - Repeat: seal the body after the back edge (Until/Forever).
+	// - Exit targets: seal after the loop is closed, since every Exit branches there.
+	class SSABuilder {
+		public:
+		SSABuilder();
+		~SSABuilder();
+
+		// Forget all state, call before generating the next Function and before it is deleted.
+		void Reset();
+
+		// Variables are interned identifier IDs and must be declared with their type before use.
+		void DeclareVariable(uint32_t variable, llvm::Type* type);
+		llvm::Type* GetVariableType(uint32_t variable) const;
+
+		void WriteVariable(uint32_t variable, llvm::BasicBlock* block, llvm::Value* value);
+		llvm::Value* ReadVariable(uint32_t variable, llvm::BasicBlock* block);
+
+		void SealBlock(llvm::BasicBlock* block);
+		bool IsSealed(llvm::BasicBlock* block) const;
+
+		private:
+		// Variables and blocks are numbered densely so definitions can live in flat arrays.
+		struct BlockInfo {
+			llvm::BasicBlock* block;
+			bool sealed;
+			std::vector<llvm::Value*> defs; // By variable slot, grown on demand.
+			llvm::SmallVector<std::pair<uint32_t, llvm::PHINode*>, 4> incompletePhis;
+		};
+
+		uint32_t GetSlot(uint32_t variable) const;
+		uint32_t GetBlock(llvm::BasicBlock* block);
+		llvm::Value*& Def(uint32_t slot, uint32_t block);
+
+		llvm::Value* Read(uint32_t slot, uint32_t block);
+		llvm::Value* ReadRecursive(uint32_t slot, uint32_t block);
+		llvm::PHINode* CreatePhi(uint32_t slot, uint32_t block);
+		llvm::Value* AddPhiOperands(uint32_t slot, llvm::PHINode* phi);
+		llvm::Value* TryRemoveTrivialPhi(uint32_t slot, llvm::PHINode* phi);
+		llvm::Value* Forward(llvm::Value* value) const;
+
+		private:
+		llvm::DenseMap<uint32_t, uint32_t> m_slots;
+		std::vector<uint32_t> m_variables;
+		std::vector<llvm::Type*> m_types;
+
+		llvm::DenseMap<llvm::BasicBlock*, uint32_t> m_blockIndices;
+		std::vector<BlockInfo> m_blocks;
+
+		// Removed phis stay allocated until Reset, so their addresses can't be reused while
+		// a definition may still point at them. Forward follows them to their replacement.
+		llvm::DenseMap<llvm::Value*, llvm::Value*> m_replaced;
+		std::vector<llvm::PHINode*> m_removedPhis;
+	};
+}
\ No newline at end of file
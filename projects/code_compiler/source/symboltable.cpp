@@ -0,0 +1,135 @@
+//	Code Compiler for BlitzLLVM
+//	Copyright(C) 2017 Michael Fabian Dirks
+//
+//	This program is free software : you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "symboltable.hpp"
+
+BlitzLLVM::SymbolTable::SymbolTable() : m_scopes(1), m_depth(0), m_clearedSlots(0) {}
+
+BlitzLLVM::SymbolTable::~SymbolTable() {}
+
+void BlitzLLVM::SymbolTable::EnterScope() {
+	m_depth++;
+
+	// Scopes are kept around after leaving them so their storage can be reused.
+	if (m_depth >= m_scopes.size()) {
+		m_scopes.emplace_back();
+	} else {
+		m_clearedSlots += m_scopes[m_depth].Clear();
+	}
+}
+
+void BlitzLLVM::SymbolTable::LeaveScope() {
+	if (m_depth > 0)
+		m_depth--;
+}
+
+uint32_t BlitzLLVM::SymbolTable::GetDepth() const {
+	return m_depth;
+}
+
+uint64_t BlitzLLVM::SymbolTable::GetClearedSlots() const {
+	return m_clearedSlots;
+}
+
+bool BlitzLLVM::SymbolTable::Declare(uint32_t id, Kind kind) {
+	switch (kind) {
+		case Kind::KindFunction:
+			return m_functions.Insert({ id, kind, 0 });
+		case Kind::KindConst:
+		case Kind::KindGlobal:
+			return m_scopes[0].Insert({ id, kind, 0 });
+		case Kind::KindLocal:
+		default:
+			return m_scopes[m_depth].Insert({ id, kind, m_depth });
+	}
+}
+
+const BlitzLLVM::SymbolTable::Symbol* BlitzLLVM::SymbolTable::Resolve(uint32_t id) const {
+	if (m_depth > 0) {
+		const Symbol* symbol = m_scopes[m_depth].Find(id);
+		if (symbol)
+			return symbol;
+	}
+	return m_scopes[0].Find(id);
+}
+
+const BlitzLLVM::SymbolTable::Symbol* BlitzLLVM::SymbolTable::ResolveFunction(uint32_t id) const {
+	return m_functions.Find(id);
+}
+
+const BlitzLLVM::SymbolTable::Symbol* BlitzLLVM::SymbolTable::ResolveGlobal(uint32_t id) const {
+	return m_scopes[0].Find(id);
+}
+
+BlitzLLVM::SymbolTable::Scope::Scope() : m_slots(16, { Interner::InvalidId, Kind::KindLocal, 0 }), m_shift(32 - 4) {}
+
+bool BlitzLLVM::SymbolTable::Scope::Insert(const Symbol& symbol) {
+	uint32_t mask = (uint32_t)m_slots.size() - 1;
+	for (uint32_t slot = Hash(symbol.id, m_shift);; slot = (slot + 1) & mask) {
+		if (m_slots[slot].id == symbol.id) {
+			return false;
+		} else if (m_slots[slot].id == Interner::InvalidId) {
+			m_slots[slot] = symbol;
+			m_used.push_back(slot);
+
+			// Keep the load factor at or below 50%.
+			if (m_used.size() * 2 > m_slots.size())
+				Grow();
+			return true;
+		}
+	}
+}
+
+const BlitzLLVM::SymbolTable::Symbol* BlitzLLVM::SymbolTable::Scope::Find(uint32_t id) const {
+	uint32_t mask = (uint32_t)m_slots.size() - 1;
+	for (uint32_t slot = Hash(id, m_shift);; slot = (slot + 1) & mask) {
+		if (m_slots[slot].id == id) {
+			return &m_slots[slot];
+		} else if (m_slots[slot].id == Interner::InvalidId) {
+			return nullptr;
+		}
+	}
+}
+
+size_t BlitzLLVM::SymbolTable::Scope::Clear() {
+	size_t count = m_used.size();
+	for (uint32_t slot : m_used)
+		m_slots[slot].id = Interner::InvalidId;
+	m_used.clear();
+	return count;
+}
+
+uint32_t BlitzLLVM::SymbolTable::Scope::Hash(uint32_t id, uint32_t shift) {
+	// Fibonacci hashing, IDs are dense so the multiply spreads neighbours apart.
+	return (id * 2654435769u) >> shift;
+}
+
+void BlitzLLVM::SymbolTable::Scope::Grow() {
+	std::vector<Symbol> old(m_slots.size() * 2, { Interner::InvalidId, Kind::KindLocal, 0 });
+	old.swap(m_slots);
+	m_shift--;
+
+	uint32_t mask = (uint32_t)m_slots.size() - 1;
+	for (uint32_t& used : m_used) {
+		const Symbol& symbol = old[used];
+		uint32_t slot = Hash(symbol.id, m_shift);
+		while (m_slots[slot].id != Interner::InvalidId)
+			slot = (slot + 1) & mask;
+		m_slots[slot] = symbol;
+		used = slot;
+	}
+}
\ No newline at end of file
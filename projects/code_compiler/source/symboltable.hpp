@@ -0,0 +1,89 @@
+//	Code Compiler for BlitzLLVM
+//	Copyright(C) 2017 Michael Fabian Dirks
+//
+//	This program is free software : you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+#include "interner.hpp"
+#include <vector>
+#include <inttypes.h>
+
+namespace BlitzLLVM {
+	class SymbolTable {
+		public:
+		enum class Kind : uint8_t {
+			KindConst,
+			KindGlobal,
+			KindLocal,
+			KindFunction,
+		};
+
+		struct Symbol {
+			uint32_t id;
+			Kind kind;
+			uint32_t depth;
+		};
+
+		public:
+		SymbolTable();
+		~SymbolTable();
+
+		// Scope 0 holds Const and Global names, every scope above it holds Local names.
+		// Functions live in their own namespace, as in Blitz.
+		void EnterScope();
+		void LeaveScope();
+		uint32_t GetDepth() const;
+
+		// Returns false if the name already exists in the target scope.
+		bool Declare(uint32_t id, Kind kind);
+		
+		// Locals in the innermost scope shadow Globals and Consts, outer Local scopes are not visible.
+		const Symbol* Resolve(uint32_t id) const;
+		const Symbol* ResolveFunction(uint32_t id) const;
+
+		// Consts and Globals only, ignoring any Local of the same name.
+		const Symbol* ResolveGlobal(uint32_t id) const;
+
+		// Slots reset so far when scopes were reused, grows with declarations rather than scope capacity.
+		uint64_t GetClearedSlots() const;
+
+		private:
+		class Scope {
+			public:
+			Scope();
+
+			bool Insert(const Symbol& symbol);
+			const Symbol* Find(uint32_t id) const;
+			size_t Clear();
+
+			private:
+			static uint32_t Hash(uint32_t id, uint32_t shift);
+			void Grow();
+
+			private:
+			std::vector<Symbol> m_slots;
+			uint32_t m_shift;
+
+			// Occupied slot indices, so Clear only touches what was inserted.
+			std::vector<uint32_t> m_used;
+		};
+
+		private:
+		Scope m_functions;
+		std::vector<Scope> m_scopes;
+		uint32_t m_depth;
+		uint64_t m_clearedSlots;
+	};
+}
\ No newline at end of file
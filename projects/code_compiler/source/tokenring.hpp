@@ -0,0 +1,83 @@
+//	Code Compiler for BlitzLLVM
+//	Copyright(C) 2017 Michael Fabian Dirks
+//
+//	This program is free software : you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+#include <atomic>
+#include <vector>
+#include <inttypes.h>
+
+namespace BlitzLLVM {
+	static const size_t CacheLineSize = 64;
+
+	// Bounded lock-free single-producer/single-consumer ring. Producer and consumer indices live on
+	// separate cache lines and each side caches the other's index to avoid needless cache misses.
+	template<typename T>
+	class TokenRing {
+		public:
+		TokenRing(size_t capacity) : m_tail(0), m_cachedHead(0), m_head(0), m_cachedTail(0) {
+			size_t size = 2;
+			while (size < capacity)
+				size <<= 1;
+			m_slots.resize(size);
+			m_mask = size - 1;
+		}
+		~TokenRing() {}
+
+		// Producer only. Returns false if the ring is full.
+		bool TryPush(T&& item) {
+			size_t tail = m_tail.load(std::memory_order_relaxed);
+			if (tail - m_cachedHead > m_mask) {
+				m_cachedHead = m_head.load(std::memory_order_acquire);
+				if (tail - m_cachedHead > m_mask)
+					return false;
+			}
+			m_slots[tail & m_mask] = std::move(item);
+			m_tail.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Consumer only. Returns false if the ring is empty.
+		bool TryPop(T& item) {
+			size_t head = m_head.load(std::memory_order_relaxed);
+			if (head == m_cachedTail) {
+				m_cachedTail = m_tail.load(std::memory_order_acquire);
+				if (head == m_cachedTail)
+					return false;
+			}
+			item = std::move(m_slots[head & m_mask]);
+			m_head.store(head + 1, std::memory_order_release);
+			return true;
+		}
+
+		size_t GetCapacity() const {
+			return m_mask + 1;
+		}
+
+		private:
+		// Producer
+		alignas(CacheLineSize) std::atomic<size_t> m_tail;
+		size_t m_cachedHead;
+
+		// Consumer
+		alignas(CacheLineSize) std::atomic<size_t> m_head;
+		size_t m_cachedTail;
+
+		// Shared, written once on construction.
+		alignas(CacheLineSize) std::vector<T> m_slots;
+		size_t m_mask;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,161 @@
+//	Code Compiler for BlitzLLVM
+//	Copyright(C) 2017 Michael Fabian Dirks
+//
+//	This program is free software : you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "tokenstream.hpp"
+
+const size_t BlitzLLVM::TokenStream::BatchSize;
+const size_t BlitzLLVM::TokenStream::RingCapacity;
+const size_t BlitzLLVM::TokenStream::SpinCount;
+
+BlitzLLVM::TokenStream::TokenStream(std::istream& in, bool pipelined) : m_lexer(in), m_isPipelined(pipelined), m_stop(false), m_isConsumerWaiting(false), m_isProducerWaiting(false) {
+	if (m_isPipelined) {
+		m_ring.reset(new TokenRing<TokenBatch>(RingCapacity));
+		m_batch.reset(new TokenBatch());
+		m_producer = std::thread(&TokenStream::Produce, this);
+	}
+}
+
+BlitzLLVM::TokenStream::~TokenStream() {
+	if (m_producer.joinable()) {
+		m_stop.store(true);
+		{
+			std::unique_lock<std::mutex> ul(m_waitLock);
+			m_notFull.notify_all();
+		}
+		m_producer.join();
+	}
+}
+
+std::pair<BlitzLLVM::Lexer::Token, std::string> BlitzLLVM::TokenStream::GetNextToken() {
+	if (!m_lookahead.empty()) {
+		auto tkn = std::move(m_lookahead.front());
+		m_lookahead.pop_front();
+		return tkn;
+	}
+	return FetchToken();
+}
+
+const std::pair<BlitzLLVM::Lexer::Token, std::string>& BlitzLLVM::TokenStream::PeekToken(size_t offset) {
+	while (m_lookahead.size() <= offset)
+		m_lookahead.push_back(FetchToken());
+	return m_lookahead[offset];
+}
+
+std::pair<BlitzLLVM::Lexer::Token, std::string> BlitzLLVM::TokenStream::FetchToken() {
+	if (m_reachedEOF)
+		return std::make_pair(Lexer::Token::TokenEOF, std::string());
+
+	std::pair<Lexer::Token, std::string> tkn;
+	if (!m_isPipelined) {
+		tkn = m_lexer.GetNextToken();
+	} else {
+		if (m_batchIndex >= m_batch->count) {
+			PopBatch();
+			m_batchIndex = 0;
+		}
+		tkn = std::move(m_batch->tokens[m_batchIndex++]);
+	}
+
+	if (tkn.first == Lexer::Token::TokenEOF) {
+		m_reachedEOF = true;
+		if (m_producer.joinable())
+			m_producer.join();
+		if (m_error)
+			std::rethrow_exception(m_error);
+	}
+	return tkn;
+}
+
+void BlitzLLVM::TokenStream::Produce() {
+	TokenBatch batch;
+	bool isEOF = false;
+	while (!isEOF && !m_stop.load(std::memory_order_relaxed)) {
+		batch.count = 0;
+		try {
+			while (batch.count < BatchSize) {
+				auto& tkn = batch.tokens[batch.count++];
+				tkn = m_lexer.GetNextToken();
+				if (tkn.first == Lexer::Token::TokenEOF) {
+					isEOF = true;
+					break;
+				}
+			}
+		} catch (...) {
+			// Hand the error to the consumer, it is rethrown once it reaches the EOF token.
+			m_error = std::current_exception();
+			batch.tokens[batch.count - 1] = std::make_pair(Lexer::Token::TokenEOF, std::string());
+			isEOF = true;
+		}
+
+		// Backpressure, wait for the consumer to free up a slot.
+		if (!PushBatch(batch))
+			return;
+	}
+}
+
+void BlitzLLVM::TokenStream::PopBatch() {
+	for (size_t spin = 0; spin < SpinCount; spin++) {
+		if (m_ring->TryPop(*m_batch)) {
+			Notify(m_isProducerWaiting, m_notFull);
+			return;
+		}
+		std::this_thread::yield();
+	}
+
+	{
+		// The fence pairs with the one in Notify: either the producer sees the flag, or we see its batch.
+		std::unique_lock<std::mutex> ul(m_waitLock);
+		m_isConsumerWaiting.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		m_notEmpty.wait(ul, [this] { return m_ring->TryPop(*m_batch); });
+		m_isConsumerWaiting.store(false, std::memory_order_relaxed);
+	}
+	Notify(m_isProducerWaiting, m_notFull);
+}
+
+bool BlitzLLVM::TokenStream::PushBatch(TokenBatch& batch) {
+	bool isPushed = false;
+	for (size_t spin = 0; spin < SpinCount && !isPushed; spin++) {
+		isPushed = m_ring->TryPush(std::move(batch));
+		if (!isPushed) {
+			if (m_stop.load(std::memory_order_relaxed))
+				return false;
+			std::this_thread::yield();
+		}
+	}
+
+	if (!isPushed) {
+		std::unique_lock<std::mutex> ul(m_waitLock);
+		m_isProducerWaiting.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		m_notFull.wait(ul, [&] { return m_stop.load() || (isPushed = m_ring->TryPush(std::move(batch))); });
+		m_isProducerWaiting.store(false, std::memory_order_relaxed);
+		if (!isPushed)
+			return false;
+	}
+	Notify(m_isConsumerWaiting, m_notEmpty);
+	return true;
+}
+
+void BlitzLLVM::TokenStream::Notify(std::atomic<bool>& isWaiting, std::condition_variable& condition) {
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (isWaiting.load(std::memory_order_relaxed)) {
+		// Taking the lock makes sure the other side is either asleep or has yet to check the ring.
+		std::unique_lock<std::mutex> ul(m_waitLock);
+		condition.notify_one();
+	}
+}
\ No newline at end of file
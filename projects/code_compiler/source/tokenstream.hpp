@@ -0,0 +1,84 @@
+//	Code Compiler for BlitzLLVM
+//	Copyright(C) 2017 Michael Fabian Dirks
+//
+//	This program is free software : you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+#include "lexer.hpp"
+#include "tokenring.hpp"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace BlitzLLVM {
+	// Token source for the compiler. In pipelined mode the Lexer runs on its own thread and hands
+	// batches of tokens over through a bounded TokenRing, so lexing and parsing overlap while memory
+	// stays bounded. The producer waits whenever the consumer falls behind. Either side spins
+	// briefly when the ring is full or empty, then sleeps until the other side signals it.
+	class TokenStream {
+		public:
+		static const size_t BatchSize = 64;
+		static const size_t RingCapacity = 64;
+		static const size_t SpinCount = 64;
+
+		public:
+		TokenStream(std::istream& in, bool pipelined);
+		~TokenStream();
+
+		std::pair<Lexer::Token, std::string> GetNextToken();
+
+		// Look ahead without consuming, 0 is the token GetNextToken would return.
+		const std::pair<Lexer::Token, std::string>& PeekToken(size_t offset = 0);
+
+		private:
+		struct TokenBatch {
+			std::array<std::pair<Lexer::Token, std::string>, BatchSize> tokens;
+			size_t count = 0;
+		};
+
+		std::pair<Lexer::Token, std::string> FetchToken();
+		void Produce();
+		void PopBatch();
+		bool PushBatch(TokenBatch& batch);
+		void Notify(std::atomic<bool>& isWaiting, std::condition_variable& condition);
+
+		private:
+		Lexer m_lexer;
+		bool m_isPipelined;
+		bool m_reachedEOF = false;
+		std::deque<std::pair<Lexer::Token, std::string>> m_lookahead;
+
+		// Pipelined mode
+		std::unique_ptr<TokenRing<TokenBatch>> m_ring;
+		std::unique_ptr<TokenBatch> m_batch;
+		size_t m_batchIndex = 0;
+		std::atomic<bool> m_stop;
+		std::exception_ptr m_error;
+		std::thread m_producer;
+
+		std::mutex m_waitLock;
+		std::condition_variable m_notEmpty;
+		std::condition_variable m_notFull;
+		std::atomic<bool> m_isConsumerWaiting;
+		std::atomic<bool> m_isProducerWaiting;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+//	Code Compiler for BlitzLLVM
+//	Copyright(C) 2017 Michael Fabian Dirks
+//
+//	This program is free software : you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.If not, see <https://www.gnu.org/licenses/>.
+
+
+// Compiler diagnostics, every input below must either compile or fail to.
+
+#include "compiler.hpp"
+#include "test.hpp"
+#include <string>
+
+static void Expect(const std::string& name, bool expectSuccess, const std::string& source) {
+	// Both token sources must lead to the same verdict.
+	for (bool pipelined : { false, true }) {
+		BlitzLLVM::Compiler comp;
+		comp.SetPipelined(pipelined);
+		Check(CompileMuted(comp, "diagnostics_" + name + ".bb", source) == expectSuccess,
+			name + (pipelined ? " (pipelined)" : "") + " should " + (expectSuccess ? "compile" : "fail"));
+	}
+}
+
+int main(int argc, char** argv) {
+	Expect("valid", true,
+		"Local a = 1\nGlobal g = 2\nFunction F(x)\n\tLocal a = x\n\tReturn a\nEnd Function\n");
+	Expect("duplicate_local", false,
+		"Local a = 1\nLocal a = 2\n");
+	Expect("duplicate_global", false,
+		"Global g = 1\nGlobal G = 2\n");
+	Expect("duplicate_function", false,
+		"Function F()\nEnd Function\nFunction f(x)\n\tReturn x\nEnd Function\n");
+	Expect("function_named_like_global", true,
+		"Global F = 1\nFunction F()\n\tReturn F\nEnd Function\n");
+	Expect("parallel_local", true,
+		"Global g = 1\nParallel For i = 0 To 10\n\tLocal v = i * g\n\tv = v + 1\nNext\ng = 2\n");
+	Expect("parallel_global_write", false,
+		"Global g = 1\nParallel For i = 0 To 10\n\tg = i\nNext\n");
+	Expect("parallel_global_suffix", false,
+		"Global g# = 1\nParallel For i = 0 To 10\n\tg# = i\nNext\n");
+	Expect("parallel_global_loop_variable", false,
+		"Global g = 1\nParallel For g = 0 To 10\nNext\n");
+	Expect("parallel_step", false,
+		"Parallel For i = 10 To 0 Step -1\nNext\n");
+	Expect("serial_step", true,
+		"For i = 10 To 0 Step -1\n\tParallel For j = 0 To i\n\tNext\nNext\n");
+	Expect("parallel_without_for", false,
+		"Parallel While 1\nWend\n");
+	Expect("parallel_pure_call", true,
+		"Global g = 1\nFunction Pure(x)\n\tReturn x * g\nEnd Function\nParallel For i = 0 To 10 : Pure(i) : Next\n");
+	Expect("parallel_call_writer", false,
+		"Global G = 1\nFunction Dummy()\n\tG = 4\nEnd Function\nParallel For i = 0 To 10 : Dummy() : Next\n");
+	Expect("parallel_call_writer_later", false,
+		"Global G = 1\nParallel For i = 0 To 10\n\tLocal v = Outer(i) + 1\nNext\n"
+		"Function Outer(x)\n\tReturn Inner(x)\nEnd Function\n"
+		"Function Inner(x)\n\tG = x\n\tReturn x\nEnd Function\n");
+	Expect("parallel_call_writer_eof", false,
+		"Global G = 1\nFunction Dummy()\n\tG = 4\nEnd Function\nParallel For i = 0 To 10\n\tDummy");
+	Expect("parallel_call_writer_global_later", false,
+		"Function W()\n\tG = 1\nEnd Function\nGlobal G\nParallel For i = 0 To 10 : W() : Next");
+	Expect("parallel_global_write_later", false,
+		"Function W()\n\tParallel For i = 0 To 10\n\t\tG = i\n\tNext\nEnd Function\nGlobal G\n");
+	Expect("parallel_local_named_like_later_global", true,
+		"Function W()\n\tLocal G = 1\nEnd Function\nGlobal G\nParallel For i = 0 To 10 : W() : Next");
+	Expect("parallel_call_writer_shadowed", false,
+		"Global G = 1\nFunction W(x)\n\tG = x\n\tReturn x\nEnd Function\nW = 5\n"
+		"Parallel For i = 0 To 10\n\ty = W(i)\nNext\n");
+	Expect("parallel_call_writer_shadowed_later", false,
+		"Global G = 1\nW = 5\nParallel For i = 0 To 10\n\ty = W(i) + W\nNext\n"
+		"Function W(x)\n\tG = x\n\tReturn x\nEnd Function\n");
+	Expect("serial_call_writer", true,
+		"Global G = 1\nFunction Dummy()\n\tG = 4\nEnd Function\nFor i = 0 To 10 : Dummy() : Next\n");
+
+	return Finish();
+}
\ No newline at end of file
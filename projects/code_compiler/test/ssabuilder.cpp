@@ -0,0 +1,209 @@
+//	Code Compiler for BlitzLLVM
+//	Copyright(C) 2017 Michael Fabian Dirks
+//
+//	This program is free software : you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.If not, see <https://www.gnu.org/licenses/>.
+
+
+// SSABuilder checks, builds IR for If, While and nested loops and verifies the phis it places.
+
+#include "interner.hpp"
+#include "ssabuilder.hpp"
+#include "test.hpp"
+#include <iostream>
+#include <stdexcept>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/Support/raw_ostream.h>
+
+static size_t CountPhis(llvm::Function* function) {
+	size_t count = 0;
+	for (llvm::BasicBlock& block : *function)
+		count += std::distance(block.phis().begin(), block.phis().end());
+	return count;
+}
+
+static llvm::Function* CreateFunction(llvm::Module& module, const char* name) {
+	llvm::Type* i32 = llvm::Type::getInt32Ty(module.getContext());
+	return llvm::Function::Create(llvm::FunctionType::get(i32, { i32 }, false), llvm::Function::ExternalLinkage, name, module);
+}
+
+int main(int argc, char** argv) {
+	BlitzLLVM::Interner& interner = BlitzLLVM::Interner::GetGlobal();
+	uint32_t x = interner.Intern("x"), y = interner.Intern("y"), i = interner.Intern("i"), j = interner.Intern("j");
+	uint32_t sum = interner.Intern("sum"), unused = interner.Intern("unused");
+
+	llvm::LLVMContext context;
+	llvm::Module module("ssabuilder", context);
+	llvm::Type* i32 = llvm::Type::getInt32Ty(context);
+	llvm::IRBuilder<> builder(context);
+	BlitzLLVM::SSABuilder ssa;
+
+	// If x Then x = x + 1 Else x = x * 2 EndIf, y is never written in either arm.
+	{
+		llvm::Function* function = CreateFunction(module, "if_else");
+		ssa.Reset();
+		ssa.DeclareVariable(x, i32);
+		ssa.DeclareVariable(y, i32);
+
+		llvm::BasicBlock* entry = llvm::BasicBlock::Create(context, "entry", function);
+		llvm::BasicBlock* thenBlock = llvm::BasicBlock::Create(context, "then", function);
+		llvm::BasicBlock* elseBlock = llvm::BasicBlock::Create(context, "else", function);
+		llvm::BasicBlock* merge = llvm::BasicBlock::Create(context, "endif", function);
+		ssa.SealBlock(entry);
+		builder.SetInsertPoint(entry);
+		ssa.WriteVariable(x, entry, function->getArg(0));
+		ssa.WriteVariable(y, entry, builder.getInt32(2));
+		builder.CreateCondBr(builder.CreateICmpNE(ssa.ReadVariable(x, entry), builder.getInt32(0)), thenBlock, elseBlock);
+		ssa.SealBlock(thenBlock);
+		ssa.SealBlock(elseBlock);
+
+		builder.SetInsertPoint(thenBlock);
+		ssa.WriteVariable(x, thenBlock, builder.CreateAdd(ssa.ReadVariable(x, thenBlock), builder.getInt32(1)));
+		builder.CreateBr(merge);
+		builder.SetInsertPoint(elseBlock);
+		ssa.WriteVariable(x, elseBlock, builder.CreateMul(ssa.ReadVariable(x, elseBlock), builder.getInt32(2)));
+		builder.CreateBr(merge);
+		ssa.SealBlock(merge);
+
+		builder.SetInsertPoint(merge);
+		builder.CreateRet(builder.CreateAdd(ssa.ReadVariable(x, merge), ssa.ReadVariable(y, merge)));
+		Check(CountPhis(function) == 1, "If: one phi for x");
+		Check(llvm::isa<llvm::PHINode>(ssa.ReadVariable(x, merge)), "If: x is merged");
+		Check(ssa.ReadVariable(y, merge) == builder.getInt32(2), "If: y is not merged");
+	}
+
+	// While i: x = x + i : i = i - 1 : Wend, unused is read but never written.
+	{
+		llvm::Function* function = CreateFunction(module, "while_loop");
+		ssa.Reset();
+		ssa.DeclareVariable(x, i32);
+		ssa.DeclareVariable(i, i32);
+		ssa.DeclareVariable(unused, i32);
+
+		llvm::BasicBlock* entry = llvm::BasicBlock::Create(context, "entry", function);
+		llvm::BasicBlock* header = llvm::BasicBlock::Create(context, "while", function);
+		llvm::BasicBlock* body = llvm::BasicBlock::Create(context, "body", function);
+		llvm::BasicBlock* exit = llvm::BasicBlock::Create(context, "wend", function);
+		ssa.SealBlock(entry);
+		builder.SetInsertPoint(entry);
+		ssa.WriteVariable(x, entry, builder.getInt32(1));
+		ssa.WriteVariable(i, entry, function->getArg(0));
+		builder.CreateBr(header);
+
+		builder.SetInsertPoint(header);
+		builder.CreateCondBr(builder.CreateICmpNE(ssa.ReadVariable(i, header), builder.getInt32(0)), body, exit);
+		ssa.SealBlock(body);
+
+		builder.SetInsertPoint(body);
+		ssa.WriteVariable(x, body, builder.CreateAdd(ssa.ReadVariable(x, body), ssa.ReadVariable(i, body)));
+		ssa.WriteVariable(i, body, builder.CreateSub(ssa.ReadVariable(i, body), builder.getInt32(1)));
+		ssa.ReadVariable(unused, body);
+		builder.CreateBr(header);
+		ssa.SealBlock(header);
+		ssa.SealBlock(exit);
+
+		builder.SetInsertPoint(exit);
+		builder.CreateRet(builder.CreateAdd(ssa.ReadVariable(x, exit), ssa.ReadVariable(unused, exit)));
+		Check(CountPhis(function) == 2, "While: phis for x and i only");
+		Check(ssa.ReadVariable(unused, exit) == builder.getInt32(0), "While: unwritten variable reads as zero");
+		Check(ssa.ReadVariable(x, exit)->getName() == "x", "While: phis are named after their variable");
+	}
+
+	// While i : j = i : While j : sum = sum + j : j = j - 1 : Wend : i = i - 1 : Wend
+	{
+		llvm::Function* function = CreateFunction(module, "nested_loops");
+		ssa.Reset();
+		ssa.DeclareVariable(i, i32);
+		ssa.DeclareVariable(j, i32);
+		ssa.DeclareVariable(sum, i32);
+
+		llvm::BasicBlock* entry = llvm::BasicBlock::Create(context, "entry", function);
+		llvm::BasicBlock* outer = llvm::BasicBlock::Create(context, "outer", function);
+		llvm::BasicBlock* outerBody = llvm::BasicBlock::Create(context, "outer_body", function);
+		llvm::BasicBlock* inner = llvm::BasicBlock::Create(context, "inner", function);
+		llvm::BasicBlock* innerBody = llvm::BasicBlock::Create(context, "inner_body", function);
+		llvm::BasicBlock* innerExit = llvm::BasicBlock::Create(context, "inner_wend", function);
+		llvm::BasicBlock* outerExit = llvm::BasicBlock::Create(context, "outer_wend", function);
+		ssa.SealBlock(entry);
+		builder.SetInsertPoint(entry);
+		ssa.WriteVariable(i, entry, function->getArg(0));
+		ssa.WriteVariable(sum, entry, builder.getInt32(0));
+		builder.CreateBr(outer);
+
+		builder.SetInsertPoint(outer);
+		builder.CreateCondBr(builder.CreateICmpNE(ssa.ReadVariable(i, outer), builder.getInt32(0)), outerBody, outerExit);
+		ssa.SealBlock(outerBody);
+
+		builder.SetInsertPoint(outerBody);
+		ssa.WriteVariable(j, outerBody, ssa.ReadVariable(i, outerBody));
+		builder.CreateBr(inner);
+
+		builder.SetInsertPoint(inner);
+		builder.CreateCondBr(builder.CreateICmpNE(ssa.ReadVariable(j, inner), builder.getInt32(0)), innerBody, innerExit);
+		ssa.SealBlock(innerBody);
+
+		builder.SetInsertPoint(innerBody);
+		ssa.WriteVariable(sum, innerBody, builder.CreateAdd(ssa.ReadVariable(sum, innerBody), ssa.ReadVariable(j, innerBody)));
+		ssa.WriteVariable(j, innerBody, builder.CreateSub(ssa.ReadVariable(j, innerBody), builder.getInt32(1)));
+		builder.CreateBr(inner);
+		ssa.SealBlock(inner);
+		ssa.SealBlock(innerExit);
+
+		builder.SetInsertPoint(innerExit);
+		ssa.WriteVariable(i, innerExit, builder.CreateSub(ssa.ReadVariable(i, innerExit), builder.getInt32(1)));
+		builder.CreateBr(outer);
+		ssa.SealBlock(outer);
+		ssa.SealBlock(outerExit);
+
+		builder.SetInsertPoint(outerExit);
+		builder.CreateRet(ssa.ReadVariable(sum, outerExit));
+		Check(CountPhis(function) == 4, "Nested loops: phis for i and sum in the outer, j and sum in the inner header");
+		Check(std::distance(outer->phis().begin(), outer->phis().end()) == 2, "Nested loops: two phis in the outer header");
+		Check(std::distance(inner->phis().begin(), inner->phis().end()) == 2, "Nested loops: two phis in the inner header");
+	}
+
+	// Reset forgets that the entry block was sealed, reading before sealing it again must not place a phi.
+	{
+		llvm::Function* function = CreateFunction(module, "unsealed_entry");
+		llvm::BasicBlock* entry = llvm::BasicBlock::Create(context, "entry", function);
+		ssa.SealBlock(entry);
+		ssa.Reset();
+		ssa.DeclareVariable(x, i32);
+
+		bool isThrown = false;
+		try {
+			ssa.ReadVariable(x, entry);
+		} catch (const std::logic_error&) {
+			isThrown = true;
+		}
+		Check(isThrown, "Unsealed entry: reading throws");
+
+		ssa.SealBlock(entry);
+		builder.SetInsertPoint(entry);
+		builder.CreateRet(ssa.ReadVariable(x, entry));
+		Check(CountPhis(function) == 0, "Unsealed entry: no phi placed");
+	}
+
+	std::string errors;
+	llvm::raw_string_ostream errorStream(errors);
+	Check(!llvm::verifyModule(module, &errorStream), "module verifies");
+	if (g_failures) {
+		module.print(llvm::errs(), nullptr);
+		std::cerr << errorStream.str() << std::endl;
+	}
+	return Finish();
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+//	Code Compiler for BlitzLLVM
+//	Copyright(C) 2017 Michael Fabian Dirks
+//
+//	This program is free software : you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.If not, see <https://www.gnu.org/licenses/>.
+
+
+// Interner and SymbolTable checks, including the scope reuse regression.
+
+#include "compiler.hpp"
+#include "interner.hpp"
+#include "symboltable.hpp"
+#include "test.hpp"
+#include <string>
+
+int main(int argc, char** argv) {
+	BlitzLLVM::Interner& interner = BlitzLLVM::Interner::GetGlobal();
+
+	// Interner
+	uint32_t foo = interner.Intern("Foo");
+	Check(interner.Intern("FOO") == foo, "Intern is case-insensitive");
+	Check(interner.Find("foo") == foo, "Find is case-insensitive");
+	Check(interner.GetName(foo) == "Foo", "first spelling is kept");
+	Check(interner.Find("NeverSeen") == BlitzLLVM::Interner::InvalidId, "Find does not intern");
+
+	// Scoping
+	{
+		BlitzLLVM::SymbolTable symbols;
+		uint32_t global = interner.Intern("TestGlobal"), local = interner.Intern("TestLocal");
+		symbols.EnterScope();
+		Check(symbols.Declare(global, BlitzLLVM::SymbolTable::Kind::KindGlobal), "declare Global");
+		Check(symbols.Declare(local, BlitzLLVM::SymbolTable::Kind::KindLocal), "declare Local");
+		Check(!symbols.Declare(interner.Intern("TESTLOCAL"), BlitzLLVM::SymbolTable::Kind::KindLocal), "duplicate Local");
+		symbols.EnterScope();
+		Check(symbols.Resolve(local) == nullptr, "outer Locals are not visible");
+		Check(symbols.Resolve(global) && symbols.Resolve(global)->kind == BlitzLLVM::SymbolTable::Kind::KindGlobal, "Globals are visible");
+		for (uint32_t idx = 0; idx < 1000; idx++)
+			symbols.Declare(interner.Intern("Many" + std::to_string(idx)), BlitzLLVM::SymbolTable::Kind::KindLocal);
+		symbols.LeaveScope();
+		symbols.EnterScope();
+		Check(symbols.Resolve(interner.Intern("Many10")) == nullptr, "reused scope starts out empty");
+		Check(symbols.Declare(interner.Intern("Many10"), BlitzLLVM::SymbolTable::Kind::KindLocal), "reused scope accepts declarations");
+		symbols.LeaveScope();
+		Check(symbols.Resolve(local) != nullptr, "Locals are visible again after leaving");
+	}
+
+	// Only assignments declare implicit Locals, calls and builtins stay unresolved.
+	{
+		BlitzLLVM::Compiler comp;
+		CompileMuted(comp, "symboltable_implicit.bb",
+			"Foo 1\nPrint Unassigned\nx = Foo(2)\nFor I = 0 To 3 Step 1\nNext\n"
+			"Function Foo(a)\n\tb% = a\n\tReturn b\nEnd Function\n");
+
+		const BlitzLLVM::SymbolTable& symbols = comp.GetSymbols();
+		Check(symbols.ResolveFunction(interner.Intern("Foo")) != nullptr, "Function is declared");
+		Check(symbols.Resolve(interner.Intern("Foo")) == nullptr, "call before the Function does not declare a Local");
+		Check(symbols.Resolve(interner.Intern("Print")) == nullptr, "builtin command does not declare a Local");
+		Check(symbols.Resolve(interner.Intern("Unassigned")) == nullptr, "read does not declare a Local");
+		Check(symbols.Resolve(interner.Intern("Step")) == nullptr, "Step does not declare a Local");
+		Check(symbols.Resolve(interner.Intern("x")) != nullptr, "assignment declares a Local");
+		Check(symbols.Resolve(interner.Intern("I")) != nullptr, "For variable declares a Local");
+		Check(symbols.Resolve(interner.Intern("b")) == nullptr, "Function Locals do not leak into the main program");
+	}
+
+	// Reusing a scope that was grown by a large Function must only reset what the next one declared.
+	{
+		BlitzLLVM::SymbolTable symbols;
+		symbols.EnterScope();
+		symbols.EnterScope();
+		for (uint32_t idx = 0; idx < 60000; idx++)
+			symbols.Declare(interner.Intern("Big" + std::to_string(idx)), BlitzLLVM::SymbolTable::Kind::KindLocal);
+		symbols.LeaveScope();
+		uint32_t a = interner.Intern("a"), b = interner.Intern("b");
+		for (uint32_t idx = 0; idx < 20000; idx++) {
+			symbols.EnterScope();
+			symbols.Declare(a, BlitzLLVM::SymbolTable::Kind::KindLocal);
+			symbols.Declare(b, BlitzLLVM::SymbolTable::Kind::KindLocal);
+			symbols.LeaveScope();
+		}
+		Check(symbols.GetClearedSlots() == 60000 + (20000 - 1) * 2, "scope reuse resets only declared slots");
+	}
+
+	return Finish();
+}
\ No newline at end of file
@@ -0,0 +1,157 @@
+//	Code Compiler for BlitzLLVM
+//	Copyright(C) 2017 Michael Fabian Dirks
+//
+//	This program is free software : you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.If not, see <https://www.gnu.org/licenses/>.
+
+
+// TokenStream checks, compares the pipelined mode against lexing in lockstep.
+
+#include "parser.hpp"
+#include "test.hpp"
+#include "tokenstream.hpp"
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef std::pair<BlitzLLVM::Lexer::Token, std::string> TokenPair;
+
+static std::string GenerateSource(size_t repeats) {
+	std::string source;
+	for (size_t idx = 0; idx < repeats; idx++) {
+		source += "; Comment " + std::to_string(idx) + "\n"
+			"Local Variable" + std::to_string(idx) + "# = " + std::to_string(idx) + ".5\n"
+			"For I = 0 To 8 : Variable = Variable + I : Next\n"
+			"If Variable = 0 Then Print \"Hello World\"\n";
+	}
+	return source;
+}
+
+static std::vector<TokenPair> ReadAll(const std::string& source, bool pipelined) {
+	std::istringstream in(source);
+	BlitzLLVM::TokenStream stream(in, pipelined);
+	std::vector<TokenPair> tokens;
+	do {
+		tokens.push_back(stream.GetNextToken());
+	} while (tokens.back().first != BlitzLLVM::Lexer::Token::TokenEOF);
+	return tokens;
+}
+
+// Hands out the given text, then fails the way a broken file would.
+class FailingBuffer : public std::streambuf {
+	public:
+	FailingBuffer(const std::string& text) : m_text(text) {
+		setg(&m_text[0], &m_text[0], &m_text[0] + m_text.size());
+	}
+
+	protected:
+	int_type underflow() override {
+		throw std::runtime_error("read failed");
+	}
+
+	private:
+	std::string m_text;
+};
+
+int main(int argc, char** argv) {
+	std::string source = GenerateSource(2000);
+	std::vector<TokenPair> reference = ReadAll(source, false);
+	Check(reference.size() > BlitzLLVM::TokenStream::BatchSize * BlitzLLVM::TokenStream::RingCapacity, "input spans many batches");
+
+	// Both modes produce the same tokens.
+	{
+		std::vector<TokenPair> pipelined = ReadAll(source, true);
+		Check(pipelined == reference, "pipelined tokens match lockstep tokens");
+	}
+
+	// Lookahead across batch boundaries, and EOF repeats once reached.
+	{
+		std::istringstream in(source);
+		BlitzLLVM::TokenStream stream(in, true);
+		const size_t lookahead = BlitzLLVM::TokenStream::BatchSize * 3 + 5;
+		bool isMatching = true;
+		for (size_t offset = 0; offset < lookahead; offset++)
+			isMatching = isMatching && (stream.PeekToken(offset) == reference[offset]);
+		Check(isMatching, "PeekToken past several batches");
+
+		for (size_t idx = 0; idx < reference.size(); idx++) {
+			if (idx + 70 < reference.size())
+				isMatching = isMatching && (stream.PeekToken(70) == reference[idx + 70]);
+			isMatching = isMatching && (stream.GetNextToken() == reference[idx]);
+		}
+		Check(isMatching, "GetNextToken and PeekToken interleaved");
+		Check(stream.GetNextToken().first == BlitzLLVM::Lexer::Token::TokenEOF, "EOF repeats");
+		Check(stream.PeekToken(3).first == BlitzLLVM::Lexer::Token::TokenEOF, "PeekToken past EOF");
+	}
+
+	// The Parser reads through the stream, its lookahead must agree with the reference tokens in both modes.
+	for (bool pipelined : { false, true }) {
+		std::istringstream in(source);
+		BlitzLLVM::Parser psr(in, pipelined);
+		bool isMatching = true;
+		size_t idx = 0, assignments = 0;
+		for (auto tkn = psr.GetNextToken(); tkn.first != BlitzLLVM::Lexer::Token::TokenEOF; tkn = psr.GetNextToken(), idx++) {
+			if (tkn.first != BlitzLLVM::Lexer::Token::TokenText)
+				continue;
+			size_t next = idx + 1;
+			if ((reference[next].first == BlitzLLVM::Lexer::Token::TokenOctothorp)
+				|| (reference[next].first == BlitzLLVM::Lexer::Token::TokenPercent)
+				|| (reference[next].first == BlitzLLVM::Lexer::Token::TokenDollar))
+				next++;
+			bool isAssignment = (reference[next].first == BlitzLLVM::Lexer::Token::TokenEqual);
+			bool isCall = (reference[idx + 1].first == BlitzLLVM::Lexer::Token::TokenRoundBracketOpen);
+			isMatching = isMatching && (psr.IsAssignmentAhead() == isAssignment) && (psr.IsCallAhead() == isCall);
+			if (isAssignment)
+				assignments++;
+		}
+		Check(isMatching && (assignments > 0), pipelined ? "Parser lookahead, pipelined" : "Parser lookahead");
+	}
+
+	// Destroying the stream early stops a producer that is blocked on a full ring.
+	{
+		std::string large = GenerateSource(20000);
+		std::istringstream in(large);
+		auto start = std::chrono::high_resolution_clock::now();
+		{
+			BlitzLLVM::TokenStream stream(in, true);
+			Check(stream.GetNextToken() == reference[0], "first token before early destruction");
+			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		}
+		double time = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		Check(time < 5000, "early destruction returns promptly");
+	}
+
+	// An exception on the lexer thread is rethrown to the consumer once it reaches the end.
+	{
+		FailingBuffer buffer(source.substr(0, 1000));
+		std::istream in(&buffer);
+		in.exceptions(std::ios::badbit);
+		BlitzLLVM::TokenStream stream(in, true);
+		size_t count = 0;
+		bool isThrown = false;
+		try {
+			while (stream.GetNextToken().first != BlitzLLVM::Lexer::Token::TokenEOF)
+				count++;
+		} catch (const std::runtime_error&) {
+			isThrown = true;
+		}
+		Check(isThrown, "lexer error reaches the consumer");
+		Check(count > 0, "tokens before the error are delivered");
+	}
+
+	return Finish();
+}
\ No newline at end of file
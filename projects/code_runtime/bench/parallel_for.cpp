@@ -0,0 +1,78 @@
+//	Runtime for BlitzLLVM
+//	Copyright(C) 2017 Michael Fabian Dirks
+//
+//	This program is free software : you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.If not, see <https://www.gnu.org/licenses/>.
+
+
+// Scaling benchmark for Parallel For, runs a per-element math workload on 1 to N threads.
+
+#include "parallel.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+struct Workload {
+	std::vector<float> values;
+	int32_t iterations;
+};
+
+static void Body(int64_t begin, int64_t end, void* context) {
+	Workload* work = static_cast<Workload*>(context);
+	for (int64_t idx = begin; idx < end; idx++) {
+		float value = work->values[idx];
+		for (int32_t iter = 0; iter < work->iterations; iter++)
+			value = std::sqrt(value * value + 1.0f) * std::sin(value) + std::cos(value * 0.5f);
+		work->values[idx] = value;
+	}
+}
+
+int main(int argc, char** argv) {
+	size_t elements = (argc > 1) ? (size_t)std::atoll(argv[1]) : 1000000;
+	int32_t iterations = (argc > 2) ? std::atoi(argv[2]) : 32;
+	size_t maxThreads = (argc > 3) ? (size_t)std::atoll(argv[3]) : std::thread::hardware_concurrency();
+	if (maxThreads == 0)
+		maxThreads = 1;
+
+	std::cout << "Parallel For: " << elements << " elements, " << iterations << " iterations per element" << std::endl;
+
+	// Powers of two, then the full thread count.
+	std::vector<size_t> threadCounts;
+	for (size_t threads = 1; threads < maxThreads; threads *= 2)
+		threadCounts.push_back(threads);
+	threadCounts.push_back(maxThreads);
+
+	double baseline = 0;
+	for (size_t threads : threadCounts) {
+		BlitzLLVM::Runtime::ThreadPool pool(threads);
+		Workload work = { std::vector<float>(elements, 1.0f), iterations };
+
+		// Warm up, then take the best of a few runs.
+		pool.ParallelFor(0, (int64_t)elements, Body, &work);
+		double best = 0;
+		for (size_t run = 0; run < 5; run++) {
+			auto start = std::chrono::high_resolution_clock::now();
+			pool.ParallelFor(0, (int64_t)elements, Body, &work);
+			double time = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+			if ((run == 0) || (time < best))
+				best = time;
+		}
+		if (threads == 1)
+			baseline = best;
+
+		std::cout << threads << " thread(s): " << best << " ms, " << (baseline / best) << "x" << std::endl;
+	}
+	return 0;
+}
\ No newline at end of file
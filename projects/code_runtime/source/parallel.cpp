@@ -0,0 +1,190 @@
+//	Runtime for BlitzLLVM
+//	Copyright(C) 2017 Michael Fabian Dirks
+//
+//	This program is free software : you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "parallel.hpp"
+#include <algorithm>
+
+// Set while a thread runs a body, so nested Parallel For loops don't wait on themselves.
+static thread_local bool t_isInParallel = false;
+
+BlitzLLVM::Runtime::ThreadPool::ThreadPool(size_t threads) : m_generation(0), m_shutdown(false), m_body(nullptr), m_context(nullptr), m_grain(1), m_remaining(0), m_active(0), m_idle(0) {
+	if (threads == 0)
+		threads = std::thread::hardware_concurrency();
+	if (threads == 0)
+		threads = 1;
+
+	for (size_t idx = 0; idx < threads; idx++)
+		m_workers.emplace_back(new Worker());
+	for (size_t idx = 1; idx < threads; idx++)
+		m_threads.emplace_back(&ThreadPool::WorkerMain, this, idx);
+}
+
+BlitzLLVM::Runtime::ThreadPool::~ThreadPool() {
+	{
+		std::unique_lock<std::mutex> ul(m_wakeLock);
+		m_shutdown = true;
+	}
+	m_wake.notify_all();
+	for (std::thread& thread : m_threads)
+		thread.join();
+}
+
+BlitzLLVM::Runtime::ThreadPool& BlitzLLVM::Runtime::ThreadPool::GetGlobal() {
+	static ThreadPool l_pool;
+	return l_pool;
+}
+
+size_t BlitzLLVM::Runtime::ThreadPool::GetThreadCount() const {
+	return m_workers.size();
+}
+
+void BlitzLLVM::Runtime::ThreadPool::ParallelFor(int64_t begin, int64_t end, ParallelBody body, void* context) {
+	if (end <= begin)
+		return;
+
+	if (t_isInParallel || (m_workers.size() == 1)) {
+		body(begin, end, context);
+		return;
+	}
+
+	std::unique_lock<std::mutex> jobLock(m_jobLock);
+
+	// Small enough for workers to notice thieves quickly, large enough to keep the checks cheap.
+	int64_t count = end - begin;
+	m_grain = count / (int64_t)(m_workers.size() * 64);
+	if (m_grain < 1)
+		m_grain = 1;
+	m_body = body;
+	m_context = context;
+	m_remaining.store(count, std::memory_order_relaxed);
+	m_active.store(m_threads.size(), std::memory_order_relaxed);
+	{
+		std::unique_lock<std::mutex> ul(m_workers[0]->lock);
+		m_workers[0]->ranges.push_back({ begin, end });
+	}
+	{
+		std::unique_lock<std::mutex> ul(m_wakeLock);
+		m_generation++;
+	}
+	m_wake.notify_all();
+
+	RunJob(0);
+
+	// Workers still reference the job until they leave RunJob.
+	while (m_active.load(std::memory_order_acquire) > 0)
+		std::this_thread::yield();
+}
+
+void BlitzLLVM::Runtime::ThreadPool::WorkerMain(size_t index) {
+	uint64_t generation = 0;
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> ul(m_wakeLock);
+			m_wake.wait(ul, [&] { return m_shutdown || (m_generation != generation); });
+			if (m_shutdown)
+				return;
+			generation = m_generation;
+		}
+
+		RunJob(index);
+		m_active.fetch_sub(1, std::memory_order_release);
+	}
+}
+
+void BlitzLLVM::Runtime::ThreadPool::RunJob(size_t index) {
+	uint32_t seed = (uint32_t)index * 2654435769u + 1;
+	Range range;
+	bool isIdle = false;
+	while (m_remaining.load(std::memory_order_acquire) > 0) {
+		if (PopOrSteal(index, range, seed)) {
+			if (isIdle) {
+				m_idle.fetch_sub(1, std::memory_order_relaxed);
+				isIdle = false;
+			}
+			Execute(index, range);
+		} else {
+			if (!isIdle) {
+				// Ask busy workers to split their ranges.
+				m_idle.fetch_add(1, std::memory_order_relaxed);
+				isIdle = true;
+			}
+			std::this_thread::yield();
+		}
+	}
+	if (isIdle)
+		m_idle.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool BlitzLLVM::Runtime::ThreadPool::PopOrSteal(size_t index, Range& range, uint32_t& seed) {
+	// Own deque first, newest (smallest) range for locality.
+	{
+		Worker& self = *m_workers[index];
+		std::unique_lock<std::mutex> ul(self.lock);
+		if (!self.ranges.empty()) {
+			range = self.ranges.back();
+			self.ranges.pop_back();
+			return true;
+		}
+	}
+
+	// Steal the oldest (largest) range, starting at a random victim.
+	size_t workers = m_workers.size();
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	size_t start = seed % workers;
+	for (size_t offset = 0; offset < workers; offset++) {
+		size_t victim = (start + offset) % workers;
+		if (victim == index)
+			continue;
+
+		Worker& other = *m_workers[victim];
+		std::unique_lock<std::mutex> ul(other.lock, std::try_to_lock);
+		if (ul.owns_lock() && !other.ranges.empty()) {
+			range = other.ranges.front();
+			other.ranges.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+
+void BlitzLLVM::Runtime::ThreadPool::Execute(size_t index, Range range) {
+	Worker& self = *m_workers[index];
+	t_isInParallel = true;
+	while (range.begin < range.end) {
+		// Split at most once per chunk, so demand is re-checked before splitting again.
+		if ((range.end - range.begin) > m_grain * 2) {
+			std::unique_lock<std::mutex> ul(self.lock);
+			if (self.ranges.empty() || (m_idle.load(std::memory_order_relaxed) > 0)) {
+				int64_t middle = range.begin + (range.end - range.begin) / 2;
+				self.ranges.push_back({ middle, range.end });
+				range.end = middle;
+			}
+		}
+
+		int64_t chunkEnd = std::min(range.begin + m_grain, range.end);
+		m_body(range.begin, chunkEnd, m_context);
+		m_remaining.fetch_sub(chunkEnd - range.begin, std::memory_order_acq_rel);
+		range.begin = chunkEnd;
+	}
+	t_isInParallel = false;
+}
+
+extern "C" void BlitzParallelFor(int32_t from, int32_t to, BlitzLLVM::Runtime::ParallelBody body, void* context) {
+	BlitzLLVM::Runtime::ThreadPool::GetGlobal().ParallelFor(from, (int64_t)to + 1, body, context);
+}
\ No newline at end of file
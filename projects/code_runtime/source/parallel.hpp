@@ -0,0 +1,92 @@
+//	Runtime for BlitzLLVM
+//	Copyright(C) 2017 Michael Fabian Dirks
+//
+//	This program is free software : you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.If not, see <https://www.gnu.org/licenses/>.
+
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <inttypes.h>
+
+namespace BlitzLLVM {
+	namespace Runtime {
+		// Outlined body of a Parallel For loop, runs the half-open iteration range [begin, end).
+		typedef void(*ParallelBody)(int64_t begin, int64_t end, void* context);
+
+		// Work-stealing pool behind Parallel For. The calling thread takes part in the work.
+		// Ranges are split lazily (lazy binary splitting): a worker runs its range in place one
+		// chunk at a time, and only halves it, keeping the upper half on its own deque, when that
+		// deque is empty or another worker is looking for work. Idle workers steal the oldest,
+		// largest ranges from the other end. Ranges thus stay whole while every worker is busy
+		// and are cut finer only where there is demand, such as uneven per-iteration cost.
+		class ThreadPool {
+			public:
+			ThreadPool(size_t threads = 0); // 0 = one thread per hardware thread.
+			~ThreadPool();
+
+			static ThreadPool& GetGlobal();
+
+			size_t GetThreadCount() const;
+
+			// Returns once every iteration has run. Nested calls from inside a body run serially.
+			void ParallelFor(int64_t begin, int64_t end, ParallelBody body, void* context);
+
+			private:
+			struct Range {
+				int64_t begin;
+				int64_t end;
+			};
+
+			struct alignas(64) Worker {
+				std::mutex lock;
+				std::deque<Range> ranges;
+			};
+
+			void WorkerMain(size_t index);
+			void RunJob(size_t index);
+			bool PopOrSteal(size_t index, Range& range, uint32_t& seed);
+			void Execute(size_t index, Range range);
+
+			private:
+			std::vector<std::unique_ptr<Worker>> m_workers; // 0 is the calling thread.
+			std::vector<std::thread> m_threads;
+
+			// Only one ParallelFor may be in flight per pool.
+			std::mutex m_jobLock;
+
+			std::mutex m_wakeLock;
+			std::condition_variable m_wake;
+			uint64_t m_generation;
+			bool m_shutdown;
+
+			// Current job
+			ParallelBody m_body;
+			void* m_context;
+			int64_t m_grain; // Iterations run in place between checks for demand.
+			std::atomic<int64_t> m_remaining;
+			std::atomic<size_t> m_active;
+			std::atomic<size_t> m_idle; // Workers looking for a range to steal.
+		};
+	}
+}
+
+// Entry point for generated code, iterates From To To inclusive as Blitz For does. There is no
+// Step, the compiler rejects it in a Parallel For head, and From > To runs no iterations.
+extern "C" void BlitzParallelFor(int32_t from, int32_t to, BlitzLLVM::Runtime::ParallelBody body, void* context);
\ No newline at end of file
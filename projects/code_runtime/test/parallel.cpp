@@ -0,0 +1,91 @@
+//	Runtime for BlitzLLVM
+//	Copyright(C) 2017 Michael Fabian Dirks
+//
+//	This program is free software : you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.If not, see <https://www.gnu.org/licenses/>.
+
+
+// ThreadPool checks, every iteration must run exactly once for any range and thread count.
+
+#include "parallel.hpp"
+#include "test.hpp"
+#include <atomic>
+#include <vector>
+
+struct Hits {
+	int64_t begin;
+	std::vector<std::atomic<int>> counts;
+};
+
+static void Count(int64_t begin, int64_t end, void* context) {
+	Hits* hits = static_cast<Hits*>(context);
+	for (int64_t idx = begin; idx < end; idx++)
+		hits->counts[idx - hits->begin]++;
+}
+
+static void Nested(int64_t begin, int64_t end, void* context) {
+	// Runs serially on the calling thread, must not wait on the pool it runs in.
+	BlitzLLVM::Runtime::ThreadPool::GetGlobal().ParallelFor(begin, end, Count, context);
+}
+
+static bool IsExactlyOnce(const Hits& hits) {
+	for (const std::atomic<int>& count : hits.counts) {
+		if (count != 1)
+			return false;
+	}
+	return true;
+}
+
+static void FromTo(int64_t begin, int64_t end, void* context) {
+	int64_t* range = static_cast<int64_t*>(context);
+	range[0] = begin;
+	range[1] = end;
+}
+
+int main(int argc, char** argv) {
+	size_t threadCounts[] = { 1, 2, 3, 7 };
+	for (size_t threads : threadCounts) {
+		BlitzLLVM::Runtime::ThreadPool pool(threads);
+		bool isExact = true;
+		for (int64_t run = 0; run < 200; run++) {
+			int64_t count = run * 37 + 1;
+			Hits hits = { -run, std::vector<std::atomic<int>>(count) };
+			pool.ParallelFor(-run, count - run, Count, &hits);
+			isExact = isExact && IsExactlyOnce(hits);
+		}
+		Check(isExact, "every iteration runs exactly once");
+
+		Hits empty = { 0, std::vector<std::atomic<int>>(0) };
+		pool.ParallelFor(5, 5, Count, &empty);
+	}
+
+	{
+		Hits hits = { 0, std::vector<std::atomic<int>>(10000) };
+		BlitzLLVM::Runtime::ThreadPool::GetGlobal().ParallelFor(0, 10000, Nested, &hits);
+		Check(IsExactlyOnce(hits), "nested Parallel For runs every iteration once");
+	}
+
+	{
+		int64_t range[2] = { 0, 0 };
+		BlitzParallelFor(5, 5, FromTo, range);
+		Check((range[0] == 5) && (range[1] == 6), "BlitzParallelFor includes To");
+	}
+
+	{
+		int64_t range[2] = { -1, -1 };
+		BlitzParallelFor(10, 0, FromTo, range);
+		Check((range[0] == -1) && (range[1] == -1), "BlitzParallelFor runs nothing when From > To");
+	}
+
+	return Finish();
+}
\ No newline at end of file
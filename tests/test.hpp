@@ -0,0 +1,57 @@
+//	Code Compiler for BlitzLLVM
+//	Copyright(C) 2017 Michael Fabian Dirks
+//
+//	This program is free software : you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program.If not, see <https://www.gnu.org/licenses/>.
+
+// Shared scaffolding for the test executables, each of which is a single translation unit.
+
+#pragma once
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+static int g_failures = 0;
+
+inline void Check(bool condition, const std::string& what) {
+	if (!condition) {
+		std::cerr << "FAILED: " << what << std::endl;
+		g_failures++;
+	}
+}
+
+// Exit code for main.
+inline int Finish() {
+	if (g_failures)
+		return 1;
+	std::cout << "All checks passed." << std::endl;
+	return 0;
+}
+
+// Compiles source from a temporary file with the compiler's token output muted. Compiler is a
+// template parameter so tests of projects without the compiler can include this header as well.
+template<typename Compiler>
+inline bool CompileMuted(Compiler& comp, const std::string& path, const std::string& source) {
+	{
+		std::ofstream out(path);
+		out << source;
+	}
+
+	std::streambuf* buf = std::cout.rdbuf(nullptr);
+	bool success = comp.Compile(path, path + ".exe");
+	std::cout.rdbuf(buf);
+	std::cout.clear();
+	std::remove(path.c_str());
+	return success;
+}
\ No newline at end of file